@@ -1,8 +1,19 @@
+#include <algorithm>
+#include <array>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
 #include <fstream>
+#include <functional>
 #include <iomanip>
+#include <list>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace backend {
@@ -12,6 +23,7 @@ struct User {
     std::string password;
     bool voted = false;
     int votedFor = -1;
+    long long votedAt = 0;
 };
 
 inline constexpr int kMaxUsers = 100;
@@ -24,7 +36,102 @@ inline constexpr const char *kCandidates[kCandidateCount] = {
 
 inline const std::string kEncryptedDataFile = "voting_data/data_encrypted.txt";
 inline const std::string kDecryptedDataFile = "voting_data/data_decrypted.txt";
+inline const std::string kPagedRollFile = "voting_data/roll_pages.dat";
+inline const std::string kStationVotersFile = "voting_data/station_voters.txt";
+inline const std::string kMerkleRootFile = "voting_data/merkle_roots.txt";
+inline const std::string kMerkleJournalFile = "voting_data/merkle_journal.txt";
+inline const std::string kStartupTimingFile = "voting_data/startup_times.txt";
+inline const std::string kLogoCacheDir = "voting_data/logo_cache";
 inline const std::string kAdminPassword = "admin123";
+inline constexpr int kConstituencyCodeLength = 5;
+inline constexpr long long kFirstFrameTargetMs = 500;
+inline constexpr long long kReadyTargetMs = 3000;
+inline constexpr long long kMinutesPerHour = 60;
+inline constexpr long long kMinutesPerDay = 24 * kMinutesPerHour;
+// Turnout only covers votes inside the election window, which bounds each
+// series to kElectionWindowDays of minute buckets. EVS_ELECTION_START (unix
+// seconds) pins the window start; otherwise it covers yesterday, today and
+// tomorrow (UTC) so a booth running past midnight keeps recording.
+inline constexpr long long kElectionWindowDays = 3;
+
+// Out-of-core roll: fixed-size records grouped into pages, a record's home
+// page picked by CNIC hash. Enabled by EVS_ROLL_CACHE_MB (the page cache
+// budget); EVS_ROLL_CAPACITY sizes the file when it is first created, and
+// an imported roll always gets kRollGrowthPercent room to grow. Capacity is
+// kept in the file's header page, and inserts stop there so pages never
+// fill past the load factor.
+inline constexpr size_t kRollRecordBytes = 64;
+inline constexpr size_t kRollRecordsPerPage = 64;
+inline constexpr size_t kRollPageBytes = kRollRecordBytes * kRollRecordsPerPage;
+inline constexpr size_t kRollDefaultCapacity = 1000000;
+inline constexpr int kRollLoadFactorPercent = 75;
+inline constexpr size_t kRollGrowthPercent = 25;
+inline constexpr size_t kRollMaxProbePages = 8;
+inline const std::string kRollHeaderMagic = "EVSROLL";
+inline constexpr size_t kRollPrefetchDepth = 16;
+
+// Login throttling: failed attempts per CNIC live in a sharded count-min
+// sketch (fixed memory, halved every half-life); attempts through this
+// process share one token bucket keyed by EVS_TERMINAL_ID, so in practice
+// it is a booth-wide limiter.
+inline constexpr size_t kThrottleShards = 16;
+inline constexpr size_t kThrottleDepth = 4;
+inline constexpr size_t kThrottleWidth = 16384;
+inline constexpr int kLockoutFailures = 5;
+inline constexpr long long kLockoutSeconds = 300;
+inline constexpr long long kFailureHalfLifeSeconds = 300;
+inline constexpr double kTerminalAttemptsPerMinute = 30.0;
+inline constexpr double kTerminalBurst = 10.0;
+
+enum class LoginGate {
+    kAllowed,
+    kTerminalLimited,
+    kLockedOut
+};
+
+using MerkleHash = std::array<uint8_t, 32>;
+
+// Merkle tree over vote records. levels[0] holds one leaf hash per user
+// (same index as the users vector); each higher level pairs up the one
+// below it, and an unpaired last node is promoted unchanged.
+struct MerkleTree {
+    std::vector<std::vector<MerkleHash>> levels;
+    // Last root this session published or verified against the roots file.
+    size_t publishedLeafCount = 0;
+    MerkleHash publishedRoot{};
+};
+
+// Sibling hashes needed to recompute the root from leaves [first, last).
+struct MerkleProof {
+    size_t first = 0;
+    size_t last = 0;
+    size_t leafCount = 0;
+    std::vector<MerkleHash> siblings;
+};
+
+// Votes per minute since originMinute (aligned to a UTC day), with hourly
+// and daily rollups and a running total so any window is an O(1) lookup.
+struct TurnoutSeries {
+    long long originMinute = 0;
+    std::vector<int> minutes;
+    std::vector<int> hours;
+    std::vector<int> days;
+    std::vector<long long> cumulative;
+};
+
+enum class TurnoutBucket {
+    kMinute,
+    kHour,
+    kDay
+};
+
+struct TurnoutIndex {
+    long long windowStart = 0;
+    long long windowEnd = 0;
+    TurnoutSeries total;
+    TurnoutSeries byCandidate[kCandidateCount];
+    std::map<std::string, TurnoutSeries> byConstituency;
+};
 
 std::string HashPassword(const std::string &password, const std::string &cnic);
 
@@ -50,6 +157,86 @@ uint64_t Fnv1aHash(const std::string &value) {
     return hash;
 }
 
+// SHA-256 (FIPS 180-4), used for the Merkle tree where collisions would
+// let an edited roll match a published root.
+MerkleHash Sha256(const std::string &message) {
+    static const uint32_t kRoundConstants[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+    uint32_t state[8] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+    auto rotr = [](uint32_t value, int bits) { return (value >> bits) | (value << (32 - bits)); };
+
+    std::string padded = message;
+    padded.push_back(static_cast<char>(0x80));
+    while (padded.size() % 64 != 56) {
+        padded.push_back('\0');
+    }
+    uint64_t bitLength = static_cast<uint64_t>(message.size()) * 8;
+    for (int shift = 56; shift >= 0; shift -= 8) {
+        padded.push_back(static_cast<char>((bitLength >> shift) & 0xff));
+    }
+
+    for (size_t chunk = 0; chunk < padded.size(); chunk += 64) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (static_cast<uint32_t>(static_cast<unsigned char>(padded[chunk + i * 4])) << 24) |
+                   (static_cast<uint32_t>(static_cast<unsigned char>(padded[chunk + i * 4 + 1])) << 16) |
+                   (static_cast<uint32_t>(static_cast<unsigned char>(padded[chunk + i * 4 + 2])) << 8) |
+                   static_cast<uint32_t>(static_cast<unsigned char>(padded[chunk + i * 4 + 3]));
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            uint32_t choose = (e & f) ^ (~e & g);
+            uint32_t temp1 = h + s1 + choose + kRoundConstants[i] + w[i];
+            uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+            uint32_t temp2 = s0 + majority;
+            h = g;
+            g = f;
+            f = e;
+            e = d + temp1;
+            d = c;
+            c = b;
+            b = a;
+            a = temp1 + temp2;
+        }
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+        state[5] += f;
+        state[6] += g;
+        state[7] += h;
+    }
+
+    MerkleHash digest;
+    for (int i = 0; i < 8; ++i) {
+        digest[i * 4] = static_cast<uint8_t>(state[i] >> 24);
+        digest[i * 4 + 1] = static_cast<uint8_t>(state[i] >> 16);
+        digest[i * 4 + 2] = static_cast<uint8_t>(state[i] >> 8);
+        digest[i * 4 + 3] = static_cast<uint8_t>(state[i]);
+    }
+    return digest;
+}
+
 std::string ToHex(uint64_t value) {
     std::stringstream ss;
     ss << std::hex << std::setw(16) << std::setfill('0') << value;
@@ -105,17 +292,89 @@ bool FromHexString(const std::string &hexInput, std::string &output) {
     return true;
 }
 
+std::string SerializeUser(const User &user) {
+    std::stringstream ss;
+    ss << user.cnic << "|"
+       << user.password << "|"
+       << (user.voted ? 1 : 0) << "|"
+       << user.votedFor << "|"
+       << user.votedAt;
+    return ss.str();
+}
+
 std::string SerializeUsers(const std::vector<User> &users) {
     std::stringstream ss;
     for (const auto &user : users) {
-        ss << user.cnic << "|"
-           << user.password << "|"
-           << (user.voted ? 1 : 0) << "|"
-           << user.votedFor << "\n";
+        ss << SerializeUser(user) << "\n";
     }
     return ss.str();
 }
 
+MerkleHash MerkleCombine(const MerkleHash &left, const MerkleHash &right) {
+    std::string input = "node:";
+    input.append(left.begin(), left.end());
+    input.append(right.begin(), right.end());
+    return Sha256(input);
+}
+
+MerkleHash MerkleParent(const std::vector<MerkleHash> &nodes, size_t parentIndex) {
+    size_t left = parentIndex * 2;
+    if (left + 1 < nodes.size()) {
+        return MerkleCombine(nodes[left], nodes[left + 1]);
+    }
+    return nodes[left];
+}
+
+// Fills every entry of parents from nodes, splitting the work across
+// threads when the level is large enough to be worth it.
+void ComputeMerkleLevel(const std::vector<MerkleHash> &nodes, std::vector<MerkleHash> &parents, unsigned threadCount) {
+    const size_t kMinNodesPerThread = 4096;
+    size_t count = parents.size();
+    size_t workers = std::min<size_t>(std::max(threadCount, 1u), (count + kMinNodesPerThread - 1) / kMinNodesPerThread);
+    if (workers <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            parents[i] = MerkleParent(nodes, i);
+        }
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    size_t chunk = (count + workers - 1) / workers;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        size_t end = std::min(begin + chunk, count);
+        threads.emplace_back([&nodes, &parents, begin, end]() {
+            for (size_t i = begin; i < end; ++i) {
+                parents[i] = MerkleParent(nodes, i);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+bool ParseUser(const std::string &line, User &user) {
+    size_t p1 = line.find('|');
+    size_t p2 = line.find('|', p1 + 1);
+    size_t p3 = line.find('|', p2 + 1);
+
+    if (p1 == std::string::npos || p2 == std::string::npos || p3 == std::string::npos) {
+        return false;
+    }
+
+    user.cnic = line.substr(0, p1);
+    user.password = line.substr(p1 + 1, p2 - p1 - 1);
+    user.voted = (line.substr(p2 + 1, p3 - p2 - 1) == "1");
+    size_t p4 = line.find('|', p3 + 1);
+    user.votedFor = std::stoi(line.substr(p3 + 1, p4 == std::string::npos ? std::string::npos : p4 - p3 - 1));
+    user.votedAt = (p4 != std::string::npos) ? std::stoll(line.substr(p4 + 1)) : 0;
+
+    if (!LooksLikeHex(user.password) || user.password.size() != 16) {
+        user.password = HashPassword(user.password, user.cnic);
+    }
+    return true;
+}
+
 void DeserializeUsers(const std::string &data, std::vector<User> &users, std::vector<int> &voteCounts) {
     users.clear();
     voteCounts.assign(kCandidateCount, 0);
@@ -127,22 +386,9 @@ void DeserializeUsers(const std::string &data, std::vector<User> &users, std::ve
             continue;
         }
 
-        size_t p1 = line.find('|');
-        size_t p2 = line.find('|', p1 + 1);
-        size_t p3 = line.find('|', p2 + 1);
-
-        if (p1 == std::string::npos || p2 == std::string::npos || p3 == std::string::npos) {
-            continue;
-        }
-
         User user;
-        user.cnic = line.substr(0, p1);
-        user.password = line.substr(p1 + 1, p2 - p1 - 1);
-        user.voted = (line.substr(p2 + 1, p3 - p2 - 1) == "1");
-        user.votedFor = std::stoi(line.substr(p3 + 1));
-
-        if (!LooksLikeHex(user.password) || user.password.size() != 16) {
-            user.password = HashPassword(user.password, user.cnic);
+        if (!ParseUser(line, user)) {
+            continue;
         }
 
         users.push_back(user);
@@ -153,6 +399,14 @@ void DeserializeUsers(const std::string &data, std::vector<User> &users, std::ve
     }
 }
 
+long long TurnoutRunningTotal(const TurnoutSeries &series, long long minuteIndex) {
+    if (minuteIndex < 0 || series.cumulative.empty()) {
+        return 0;
+    }
+    size_t index = std::min(static_cast<size_t>(minuteIndex), series.cumulative.size() - 1);
+    return series.cumulative[index];
+}
+
 }  // namespace
 
 bool IsValidCnic(const std::string &cnic) {
@@ -173,6 +427,485 @@ std::string HashPassword(const std::string &password, const std::string &cnic) {
     return ToHex(Fnv1aHash(cnic + ":" + password));
 }
 
+MerkleHash HashVoteRecord(const User &user) {
+    return Sha256("leaf:" + SerializeUser(user));
+}
+
+MerkleHash MerkleRoot(const MerkleTree &tree) {
+    if (tree.levels.empty() || tree.levels[0].empty()) {
+        return MerkleHash{};
+    }
+    return tree.levels.back()[0];
+}
+
+size_t MerkleLeafCount(const MerkleTree &tree) {
+    return tree.levels.empty() ? 0 : tree.levels[0].size();
+}
+
+// Sets (or appends, when index == leaf count) one leaf and rehashes its
+// path to the root: O(log n) per vote.
+void UpdateMerkleLeaf(MerkleTree &tree, size_t index, const MerkleHash &leafHash) {
+    if (tree.levels.empty()) {
+        tree.levels.emplace_back();
+    }
+    if (index == tree.levels[0].size()) {
+        tree.levels[0].push_back(leafHash);
+    } else {
+        tree.levels[0][index] = leafHash;
+    }
+
+    size_t nodeIndex = index;
+    for (size_t level = 0; tree.levels[level].size() > 1; ++level) {
+        if (level + 1 == tree.levels.size()) {
+            tree.levels.emplace_back();
+        }
+        const auto &nodes = tree.levels[level];
+        auto &parents = tree.levels[level + 1];
+        size_t parentIndex = nodeIndex / 2;
+        MerkleHash parent = MerkleParent(nodes, parentIndex);
+        if (parentIndex == parents.size()) {
+            parents.push_back(parent);
+        } else {
+            parents[parentIndex] = parent;
+        }
+        nodeIndex = parentIndex;
+    }
+}
+
+MerkleTree BuildMerkleTreeFromLeaves(std::vector<MerkleHash> leaves,
+                                     unsigned threadCount = std::thread::hardware_concurrency()) {
+    MerkleTree tree;
+    tree.levels.push_back(std::move(leaves));
+    while (tree.levels.back().size() > 1) {
+        std::vector<MerkleHash> parents((tree.levels.back().size() + 1) / 2);
+        ComputeMerkleLevel(tree.levels.back(), parents, threadCount);
+        tree.levels.push_back(std::move(parents));
+    }
+    return tree;
+}
+
+MerkleTree BuildMerkleTree(const std::vector<User> &users, unsigned threadCount = std::thread::hardware_concurrency()) {
+    std::vector<MerkleHash> leaves;
+    leaves.reserve(users.size());
+    for (const auto &user : users) {
+        leaves.push_back(HashVoteRecord(user));
+    }
+    return BuildMerkleTreeFromLeaves(std::move(leaves), threadCount);
+}
+
+// Recomputes the root from the stored records in parallel and compares it
+// with the expected (published or in-memory) root.
+bool VerifyMerkleTree(const std::vector<User> &users, const MerkleHash &expectedRoot,
+                      unsigned threadCount = std::thread::hardware_concurrency()) {
+    return MerkleRoot(BuildMerkleTree(users, threadCount)) == expectedRoot;
+}
+
+MerkleProof BuildMerkleProof(const MerkleTree &tree, size_t first, size_t last) {
+    MerkleProof proof;
+    proof.leafCount = tree.levels.empty() ? 0 : tree.levels[0].size();
+    proof.first = first;
+    proof.last = std::min(last, proof.leafCount);
+    if (proof.first >= proof.last) {
+        return proof;
+    }
+
+    size_t lo = proof.first;
+    size_t hi = proof.last - 1;
+    for (size_t level = 0; tree.levels[level].size() > 1; ++level) {
+        const auto &nodes = tree.levels[level];
+        if (lo % 2 == 1) {
+            proof.siblings.push_back(nodes[lo - 1]);
+        }
+        if (hi % 2 == 0 && hi + 1 < nodes.size()) {
+            proof.siblings.push_back(nodes[hi + 1]);
+        }
+        lo /= 2;
+        hi /= 2;
+    }
+    return proof;
+}
+
+MerkleProof BuildMerkleProof(const MerkleTree &tree, size_t index) {
+    return BuildMerkleProof(tree, index, index + 1);
+}
+
+// Auditor side: needs only the records in the proof's range, the proof, and
+// a published root with its leaf count. A proof built for a different tree
+// size is rejected rather than trusted.
+bool VerifyMerkleProof(std::vector<MerkleHash> known, const MerkleProof &proof, const MerkleHash &expectedRoot,
+                       size_t expectedLeafCount) {
+    if (proof.leafCount != expectedLeafCount || proof.first >= proof.last || proof.last > proof.leafCount ||
+        known.size() != proof.last - proof.first) {
+        return false;
+    }
+
+    size_t lo = proof.first;
+    size_t hi = proof.last - 1;
+    size_t levelSize = proof.leafCount;
+    size_t next = 0;
+    while (levelSize > 1) {
+        if (lo % 2 == 1) {
+            if (next >= proof.siblings.size()) {
+                return false;
+            }
+            known.insert(known.begin(), proof.siblings[next++]);
+            lo -= 1;
+        }
+        if (hi % 2 == 0 && hi + 1 < levelSize) {
+            if (next >= proof.siblings.size()) {
+                return false;
+            }
+            known.push_back(proof.siblings[next++]);
+            hi += 1;
+        }
+
+        std::vector<MerkleHash> parents;
+        parents.reserve((known.size() + 1) / 2);
+        for (size_t i = 0; i < known.size(); i += 2) {
+            parents.push_back(i + 1 < known.size() ? MerkleCombine(known[i], known[i + 1]) : known[i]);
+        }
+        known.swap(parents);
+        lo /= 2;
+        hi /= 2;
+        levelSize = (levelSize + 1) / 2;
+    }
+    return next == proof.siblings.size() && known.size() == 1 && known[0] == expectedRoot;
+}
+
+bool VerifyMerkleProof(const std::vector<User> &records, const MerkleProof &proof, const MerkleHash &expectedRoot,
+                       size_t expectedLeafCount) {
+    std::vector<MerkleHash> leaves;
+    leaves.reserve(records.size());
+    for (const auto &record : records) {
+        leaves.push_back(HashVoteRecord(record));
+    }
+    return VerifyMerkleProof(std::move(leaves), proof, expectedRoot, expectedLeafCount);
+}
+
+// Appends "LEAF_COUNT|ROOT" and flushes it; false when it could not be written.
+bool PublishMerkleRoot(MerkleTree &tree) {
+    std::ofstream out(kMerkleRootFile.c_str(), std::ios::app);
+    MerkleHash root = MerkleRoot(tree);
+    out << MerkleLeafCount(tree) << "|" << ToHexString(std::string(root.begin(), root.end())) << "\n";
+    out.flush();
+    if (!out) {
+        return false;
+    }
+    tree.publishedLeafCount = MerkleLeafCount(tree);
+    tree.publishedRoot = root;
+    return true;
+}
+
+// Reads the last "LEAF_COUNT|ROOT" line; false when nothing was published.
+// Only the tail is read, since the file grows by one line per update.
+bool LoadPublishedMerkleRoot(size_t &leafCountOut, MerkleHash &rootOut) {
+    const std::streamoff kTailBytes = 256;
+    std::ifstream in(kMerkleRootFile.c_str(), std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    std::streamoff start = size > kTailBytes ? size - kTailBytes : 0;
+    std::string tail(static_cast<size_t>(size - start), '\0');
+    in.seekg(start);
+    in.read(&tail[0], static_cast<std::streamsize>(tail.size()));
+
+    std::stringstream lines(tail);
+    std::string line;
+    std::string lastLine;
+    while (std::getline(lines, line)) {
+        if (!line.empty()) {
+            lastLine = line;
+        }
+    }
+
+    size_t sep = lastLine.find('|');
+    std::string rootBytes;
+    if (sep == std::string::npos || sep == 0 || !IsDigits(lastLine.substr(0, sep)) ||
+        !FromHexString(lastLine.substr(sep + 1), rootBytes) || rootBytes.size() != rootOut.size()) {
+        return false;
+    }
+    leafCountOut = static_cast<size_t>(std::stoull(lastLine.substr(0, sep)));
+    std::copy(rootBytes.begin(), rootBytes.end(), rootOut.begin());
+    return true;
+}
+
+// True when the tree matches the last published root. With no published
+// root yet, the current root is published as the baseline.
+bool MatchesPublishedMerkleRoot(MerkleTree &tree) {
+    size_t leafCount = 0;
+    MerkleHash root{};
+    if (!LoadPublishedMerkleRoot(leafCount, root)) {
+        return PublishMerkleRoot(tree);
+    }
+    if (leafCount != MerkleLeafCount(tree) || root != MerkleRoot(tree)) {
+        return false;
+    }
+    tree.publishedLeafCount = leafCount;
+    tree.publishedRoot = root;
+    return true;
+}
+
+// True when the roots file still ends with the root this session last
+// published or verified.
+bool PublishedMerkleRootIntact(const MerkleTree &tree) {
+    size_t leafCount = 0;
+    MerkleHash root{};
+    return LoadPublishedMerkleRoot(leafCount, root) && leafCount == tree.publishedLeafCount &&
+           root == tree.publishedRoot;
+}
+
+// Checks stored leaves [first, first + storedLeaves.size()) against the last
+// line of merkle_roots.txt, LEAF_COUNT included. The siblings come from the
+// in-memory tree, which every update publishes, so they describe that root.
+bool AuditAgainstPublishedRoot(const MerkleTree &tree, size_t first, std::vector<MerkleHash> storedLeaves) {
+    size_t leafCount = 0;
+    MerkleHash root{};
+    if (!LoadPublishedMerkleRoot(leafCount, root)) {
+        return false;
+    }
+    MerkleProof proof = BuildMerkleProof(tree, first, first + storedLeaves.size());
+    return VerifyMerkleProof(std::move(storedLeaves), proof, root, leafCount);
+}
+
+// Write-ahead journal: "SLOT|RECORD" (record encrypted like the TXT roll)
+// for the one update in flight. It is written before the new root is
+// published and removed once the record is stored.
+bool WriteMerkleJournal(size_t slot, const User &user) {
+    std::ofstream out(kMerkleJournalFile.c_str(), std::ios::trunc);
+    out << slot << "|" << ToHexString(XorCipher(SerializeUser(user), kAdminPassword)) << "\n";
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+bool ReadMerkleJournal(size_t &slotOut, User &userOut) {
+    std::ifstream in(kMerkleJournalFile.c_str());
+    std::string line;
+    if (!std::getline(in, line)) {
+        return false;
+    }
+    size_t sep = line.find('|');
+    std::string record;
+    if (sep == std::string::npos || sep == 0 || !IsDigits(line.substr(0, sep)) ||
+        !FromHexString(line.substr(sep + 1), record)) {
+        return false;
+    }
+    slotOut = static_cast<size_t>(std::stoull(line.substr(0, sep)));
+    return ParseUser(XorCipher(record, kAdminPassword), userOut);
+}
+
+void ClearMerkleJournal() {
+    std::remove(kMerkleJournalFile.c_str());
+}
+
+// One record update, in crash-safe order: journal the record, publish the
+// root that includes it, then store it. A crash before the publish leaves
+// storage on the old published root; a crash after it leaves a journal entry
+// that RecoverPublishedMerkleRoot replays. If store() fails the old leaf is
+// restored and republished.
+bool CommitMerkleUpdate(MerkleTree &tree, size_t leafIndex, const MerkleHash &leafHash, size_t slot,
+                        const User &user, const std::function<bool()> &store) {
+    bool appended = tree.levels.empty() || leafIndex >= tree.levels[0].size();
+    MerkleHash oldLeaf = appended ? MerkleHash{} : tree.levels[0][leafIndex];
+    auto restore = [&tree, appended, leafIndex, &oldLeaf]() {
+        if (!appended) {
+            UpdateMerkleLeaf(tree, leafIndex, oldLeaf);
+            return;
+        }
+        std::vector<MerkleHash> leaves = tree.levels[0];
+        leaves.pop_back();
+        size_t publishedLeafCount = tree.publishedLeafCount;
+        MerkleHash publishedRoot = tree.publishedRoot;
+        tree = BuildMerkleTreeFromLeaves(std::move(leaves));
+        tree.publishedLeafCount = publishedLeafCount;
+        tree.publishedRoot = publishedRoot;
+    };
+
+    UpdateMerkleLeaf(tree, leafIndex, leafHash);
+    if (!WriteMerkleJournal(slot, user)) {
+        restore();
+        return false;
+    }
+    if (!PublishMerkleRoot(tree)) {
+        restore();
+        ClearMerkleJournal();
+        return false;
+    }
+    if (!store()) {
+        restore();
+        PublishMerkleRoot(tree);
+        ClearMerkleJournal();
+        return false;
+    }
+    ClearMerkleJournal();
+    return true;
+}
+
+// Startup check. When storage does not match the last published root and a
+// journal entry is pending, replay() stores that record and updates the
+// tree, and the check is repeated.
+bool RecoverPublishedMerkleRoot(MerkleTree &tree, const std::function<bool(size_t, const User &)> &replay) {
+    if (MatchesPublishedMerkleRoot(tree)) {
+        ClearMerkleJournal();
+        return true;
+    }
+    size_t slot = 0;
+    User user;
+    if (!ReadMerkleJournal(slot, user) || !replay(slot, user) || !MatchesPublishedMerkleRoot(tree)) {
+        return false;
+    }
+    ClearMerkleJournal();
+    return true;
+}
+
+// Reads an environment variable as a non-negative number, 0 when unset.
+size_t EnvSize(const char *name) {
+    const char *value = std::getenv(name);
+    if (value == nullptr || value[0] == '\0' || !IsDigits(value)) {
+        return 0;
+    }
+    return static_cast<size_t>(std::strtoull(value, nullptr, 10));
+}
+
+// The leading digits of a CNIC encode the issuing locality; they stand in
+// for the constituency until the roll carries one explicitly.
+std::string ConstituencyOf(const std::string &cnic) {
+    return cnic.substr(0, kConstituencyCodeLength);
+}
+
+// Bulk loads pass keepRunningTotal = false and call RebuildTurnoutTotals
+// once at the end, so records can arrive in any order.
+void RecordTurnout(TurnoutSeries &series, long long timestamp, bool keepRunningTotal = true) {
+    long long minute = timestamp / 60;
+    long long dayStart = minute - minute % kMinutesPerDay;
+    if (series.minutes.empty()) {
+        series.originMinute = dayStart;
+    } else if (minute < series.originMinute) {
+        long long shiftDays = (series.originMinute - dayStart) / kMinutesPerDay;
+        series.minutes.insert(series.minutes.begin(), shiftDays * kMinutesPerDay, 0);
+        if (keepRunningTotal) {
+            series.cumulative.insert(series.cumulative.begin(), shiftDays * kMinutesPerDay, 0);
+        }
+        series.hours.insert(series.hours.begin(), shiftDays * 24, 0);
+        series.days.insert(series.days.begin(), shiftDays, 0);
+        series.originMinute = dayStart;
+    }
+
+    size_t index = static_cast<size_t>(minute - series.originMinute);
+    if (index >= series.minutes.size()) {
+        long long runningTotal = series.cumulative.empty() ? 0 : series.cumulative.back();
+        series.minutes.resize(index + 1, 0);
+        if (keepRunningTotal) {
+            series.cumulative.resize(index + 1, runningTotal);
+        }
+        series.hours.resize(index / kMinutesPerHour + 1, 0);
+        series.days.resize(index / kMinutesPerDay + 1, 0);
+    }
+
+    series.minutes[index] += 1;
+    series.hours[index / kMinutesPerHour] += 1;
+    series.days[index / kMinutesPerDay] += 1;
+    // Live votes land in the last minute, so this touches one entry; only
+    // out-of-order timestamps pay for the suffix.
+    for (size_t i = index; keepRunningTotal && i < series.cumulative.size(); ++i) {
+        series.cumulative[i] += 1;
+    }
+}
+
+void RebuildTurnoutTotals(TurnoutSeries &series) {
+    series.cumulative.resize(series.minutes.size());
+    long long runningTotal = 0;
+    for (size_t i = 0; i < series.minutes.size(); ++i) {
+        runningTotal += series.minutes[i];
+        series.cumulative[i] = runningTotal;
+    }
+}
+
+void RebuildTurnoutTotals(TurnoutIndex &index) {
+    RebuildTurnoutTotals(index.total);
+    for (auto &series : index.byCandidate) {
+        RebuildTurnoutTotals(series);
+    }
+    for (auto &entry : index.byConstituency) {
+        RebuildTurnoutTotals(entry.second);
+    }
+}
+
+TurnoutIndex NewTurnoutIndex(long long now) {
+    const long long kSecondsPerDay = kMinutesPerDay * 60;
+    TurnoutIndex index;
+    long long pinnedStart = static_cast<long long>(EnvSize("EVS_ELECTION_START"));
+    if (pinnedStart > 0) {
+        index.windowStart = pinnedStart;
+    } else {
+        index.windowStart = now - now % kSecondsPerDay - kSecondsPerDay;
+    }
+    index.windowEnd = index.windowStart + kElectionWindowDays * kSecondsPerDay;
+    return index;
+}
+
+// Votes stamped outside the window (a reset booth clock, a corrupt line)
+// still count in the totals but are left out of the turnout series.
+void RecordVote(TurnoutIndex &index, const User &user, bool keepRunningTotal = true) {
+    if (!user.voted || user.votedAt < index.windowStart || user.votedAt >= index.windowEnd) {
+        return;
+    }
+    RecordTurnout(index.total, user.votedAt, keepRunningTotal);
+    if (user.votedFor >= 0 && user.votedFor < kCandidateCount) {
+        RecordTurnout(index.byCandidate[user.votedFor], user.votedAt, keepRunningTotal);
+    }
+    RecordTurnout(index.byConstituency[ConstituencyOf(user.cnic)], user.votedAt, keepRunningTotal);
+}
+
+TurnoutIndex BuildTurnoutIndex(const std::vector<User> &users) {
+    TurnoutIndex index = NewTurnoutIndex(static_cast<long long>(std::time(nullptr)));
+    for (const auto &user : users) {
+        RecordVote(index, user, false);
+    }
+    RebuildTurnoutTotals(index);
+    return index;
+}
+
+// Votes cast in [fromTime, toTime), both unix seconds, at minute resolution.
+long long TurnoutBetween(const TurnoutSeries &series, long long fromTime, long long toTime) {
+    if (series.minutes.empty() || toTime <= fromTime) {
+        return 0;
+    }
+    long long first = fromTime / 60 - series.originMinute;
+    long long last = toTime / 60 - series.originMinute;
+    return TurnoutRunningTotal(series, last - 1) - TurnoutRunningTotal(series, first - 1);
+}
+
+// Count in the minute, hour, or day bucket that contains timestamp.
+int TurnoutInBucket(const TurnoutSeries &series, TurnoutBucket bucket, long long timestamp) {
+    long long index = timestamp / 60 - series.originMinute;
+    if (series.minutes.empty() || index < 0) {
+        return 0;
+    }
+    switch (bucket) {
+        case TurnoutBucket::kMinute:
+            return static_cast<size_t>(index) < series.minutes.size() ? series.minutes[index] : 0;
+        case TurnoutBucket::kHour:
+            index /= kMinutesPerHour;
+            return static_cast<size_t>(index) < series.hours.size() ? series.hours[index] : 0;
+        case TurnoutBucket::kDay:
+            index /= kMinutesPerDay;
+            return static_cast<size_t>(index) < series.days.size() ? series.days[index] : 0;
+    }
+    return 0;
+}
+
+// Appends "FIRST_FRAME_MS|READY_MS|STATUS" so booth startup can be tracked
+// per machine. STATUS is "failed" when the roll did not load, and READY_MS
+// is then when that was known.
+void AppendStartupTiming(long long firstFrameMs, long long readyMs, bool rollLoaded) {
+    std::ofstream out(kStartupTimingFile.c_str(), std::ios::app);
+    if (out) {
+        out << firstFrameMs << "|" << readyMs << "|" << (rollLoaded ? "ok" : "failed") << "\n";
+    }
+}
+
 void SaveData(const std::vector<User> &users) {
     std::string plain = SerializeUsers(users);
     std::string encrypted = XorCipher(plain, kAdminPassword);
@@ -219,4 +952,654 @@ void LoadData(std::vector<User> &users, std::vector<int> &voteCounts) {
     }
 }
 
+// Stores users[index] (index == users.size() appends) through the journal.
+bool CommitUserRecord(std::vector<User> &users, MerkleTree &tree, size_t index, const User &user) {
+    if (index > users.size()) {
+        return false;
+    }
+    return CommitMerkleUpdate(tree, index, HashVoteRecord(user), index, user, [&users, index, &user]() {
+        if (index == users.size()) {
+            users.push_back(user);
+        } else {
+            users[index] = user;
+        }
+        SaveData(users);
+        return true;
+    });
+}
+
+// Startup check for the TXT roll, replaying an interrupted update if needed.
+bool RecoverTextRoll(std::vector<User> &users, std::vector<int> &voteCounts, MerkleTree &tree) {
+    if (voteCounts.size() != static_cast<size_t>(kCandidateCount)) {
+        voteCounts.assign(kCandidateCount, 0);
+    }
+    return RecoverPublishedMerkleRoot(tree, [&users, &voteCounts, &tree](size_t index, const User &user) {
+        if (index > users.size()) {
+            return false;
+        }
+        if (index == users.size()) {
+            users.push_back(user);
+        } else {
+            if (users[index].votedFor >= 0 && users[index].votedFor < kCandidateCount) {
+                voteCounts[users[index].votedFor] -= 1;
+            }
+            users[index] = user;
+        }
+        if (user.votedFor >= 0 && user.votedFor < kCandidateCount) {
+            voteCounts[user.votedFor] += 1;
+        }
+        SaveData(users);
+        UpdateMerkleLeaf(tree, index, HashVoteRecord(user));
+        return true;
+    });
+}
+
+size_t RollCacheBudgetBytes() {
+    return EnvSize("EVS_ROLL_CACHE_MB") * 1024 * 1024;
+}
+
+std::vector<std::string> LoadStationVoters() {
+    std::vector<std::string> cnics;
+    std::ifstream in(kStationVotersFile.c_str());
+    std::string line;
+    while (std::getline(in, line)) {
+        if (IsValidCnic(line)) {
+            cnics.push_back(line);
+        }
+    }
+    return cnics;
+}
+
+// Voter roll kept on disk. Records are encrypted one at a time with the
+// same XOR key as the text file, so a page never has to be decoded whole;
+// an all-zero record is an empty slot. The first page of the file is a
+// header ("EVSROLL|CAPACITY|COUNT"); record pages follow it. Lookups probe
+// at most kRollMaxProbePages pages from the CNIC's home page, stopping at
+// the record or a page with a free slot, and at most maxPages pages are
+// held in an LRU cache.
+class PagedRoll {
+public:
+    static bool Create(const std::string &path, size_t capacity) {
+        size_t pages = (capacity * 100 / kRollLoadFactorPercent + kRollRecordsPerPage - 1) / kRollRecordsPerPage;
+        std::ofstream out(path.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        std::string header = EncodeHeader(capacity, 0);
+        out.write(header.data(), header.size());
+        std::string emptyPage(kRollPageBytes, '\0');
+        for (size_t i = 0; i < std::max<size_t>(pages, 1); ++i) {
+            out.write(emptyPage.data(), emptyPage.size());
+        }
+        return static_cast<bool>(out);
+    }
+
+    bool Open(const std::string &path, size_t memoryBudgetBytes) {
+        Close();
+        file_.open(path.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+        if (!file_) {
+            return false;
+        }
+        std::string header(kRollPageBytes, '\0');
+        file_.read(&header[0], kRollPageBytes);
+        if (!file_ || !DecodeHeader(header, capacity_, recordCount_)) {
+            Close();
+            return false;
+        }
+        file_.seekg(0, std::ios::end);
+        pageCount_ = static_cast<size_t>(file_.tellg()) / kRollPageBytes - 1;
+        maxPages_ = std::max<size_t>(memoryBudgetBytes / kRollPageBytes, 1);
+        return pageCount_ > 0;
+    }
+
+    void Close() {
+        if (file_.is_open()) {
+            file_.close();
+        }
+        file_.clear();
+        cache_.clear();
+        lru_.clear();
+        pageCount_ = 0;
+        capacity_ = 0;
+        recordCount_ = 0;
+    }
+
+    size_t PageCount() const {
+        return pageCount_;
+    }
+
+    size_t Capacity() const {
+        return capacity_;
+    }
+
+    size_t RecordCount() const {
+        return recordCount_;
+    }
+
+    bool Find(const std::string &cnic, User &userOut, size_t &slotOut) {
+        auto arrival = arrivalPosition_.find(cnic);
+        if (arrival != arrivalPosition_.end()) {
+            nextArrival_ = arrival->second + 1;
+        }
+
+        const std::string key = cnic + "|";
+        size_t home = HomePage(cnic);
+        for (size_t probe = 0; probe < MaxProbes(); ++probe) {
+            size_t page = (home + probe) % pageCount_;
+            const std::string &bytes = Page(page);
+            for (size_t i = 0; i < kRollRecordsPerPage; ++i) {
+                size_t offset = i * kRollRecordBytes;
+                if (bytes[offset] == '\0') {
+                    return false;
+                }
+                if (XorCipher(bytes.substr(offset, key.size()), kAdminPassword) == key) {
+                    slotOut = page * kRollRecordsPerPage + i;
+                    return DecodeRecord(bytes.substr(offset, kRollRecordBytes), userOut);
+                }
+            }
+        }
+        return false;
+    }
+
+    bool Read(size_t slot, User &userOut) {
+        const std::string &bytes = Page(slot / kRollRecordsPerPage);
+        return DecodeRecord(bytes.substr((slot % kRollRecordsPerPage) * kRollRecordBytes, kRollRecordBytes), userOut);
+    }
+
+    // Where Insert would put cnic. Fails with the roll full: at capacity, or
+    // (practically never below the load factor) no free slot within the
+    // probe limit.
+    bool FindFreeSlot(const std::string &cnic, size_t &slotOut) {
+        if (recordCount_ >= capacity_) {
+            return false;
+        }
+        size_t home = HomePage(cnic);
+        for (size_t probe = 0; probe < MaxProbes(); ++probe) {
+            size_t page = (home + probe) % pageCount_;
+            const std::string &bytes = Page(page);
+            for (size_t i = 0; i < kRollRecordsPerPage; ++i) {
+                if (bytes[i * kRollRecordBytes] == '\0') {
+                    slotOut = page * kRollRecordsPerPage + i;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Caller checks for duplicates first.
+    bool Insert(const User &user, size_t &slotOut) {
+        return FindFreeSlot(user.cnic, slotOut) && Write(slotOut, user);
+    }
+
+    // Write-through: the record goes to disk first, and the cached page, if
+    // any, is patched only once that write succeeded. Filling an empty slot
+    // also bumps the header's record count.
+    bool Write(size_t slot, const User &user) {
+        std::string record = EncodeRecord(user);
+        size_t page = slot / kRollRecordsPerPage;
+        if (record.empty() || page >= pageCount_) {
+            return false;
+        }
+        size_t offset = (slot % kRollRecordsPerPage) * kRollRecordBytes;
+        bool filling = Page(page)[offset] == '\0';
+        file_.clear();
+        file_.seekp(static_cast<std::streamoff>((page + 1) * kRollPageBytes + offset));
+        file_.write(record.data(), record.size());
+        file_.flush();
+        if (!file_) {
+            file_.clear();
+            return false;
+        }
+
+        auto cached = cache_.find(page);
+        if (cached != cache_.end()) {
+            cached->second.bytes.replace(offset, kRollRecordBytes, record);
+        }
+        if (filling) {
+            recordCount_ += 1;
+            WriteHeader();
+        }
+        return true;
+    }
+
+    // Hash of one page; the roll's Merkle tree has one leaf per page.
+    MerkleHash PageDigest(size_t page) {
+        return DigestPageBytes(Page(page));
+    }
+
+    // The page's hash once user is written to slot, without writing it.
+    bool PageDigestWith(size_t slot, const User &user, MerkleHash &digestOut) {
+        std::string record = EncodeRecord(user);
+        if (record.empty()) {
+            return false;
+        }
+        std::string bytes = Page(slot / kRollRecordsPerPage);
+        bytes.replace((slot % kRollRecordsPerPage) * kRollRecordBytes, kRollRecordBytes, record);
+        digestOut = DigestPageBytes(bytes);
+        return true;
+    }
+
+    // Hash of the page as stored on disk, bypassing the cache (audits).
+    MerkleHash DiskPageDigest(size_t page) {
+        std::string bytes;
+        ReadPageFromDisk(page, bytes);
+        return DigestPageBytes(bytes);
+    }
+
+    // Station voters in expected arrival order; each lookup moves the
+    // prefetch window to just past that voter.
+    void SetArrivalOrder(const std::vector<std::string> &cnics) {
+        arrivalOrder_ = cnics;
+        arrivalPosition_.clear();
+        for (size_t i = 0; i < arrivalOrder_.size(); ++i) {
+            arrivalPosition_[arrivalOrder_[i]] = i;
+        }
+        nextArrival_ = 0;
+    }
+
+    void PrefetchUpcoming() {
+        size_t depth = std::min(kRollPrefetchDepth, std::max<size_t>(maxPages_ / 2, 1));
+        for (size_t i = nextArrival_; i < arrivalOrder_.size() && i < nextArrival_ + depth; ++i) {
+            Page(HomePage(arrivalOrder_[i]));
+        }
+    }
+
+    // Streams every page once without touching the cache.
+    void ForEachPage(const std::function<void(size_t, const std::string &)> &visit) {
+        std::string bytes(kRollPageBytes, '\0');
+        for (size_t page = 0; page < pageCount_; ++page) {
+            ReadPageFromDisk(page, bytes);
+            visit(page, bytes);
+        }
+    }
+
+    void ForEachRecord(const std::function<void(size_t, const User &)> &visit) {
+        ForEachPage([&visit](size_t page, const std::string &bytes) {
+            ForEachRecordInPage(page, bytes, visit);
+        });
+    }
+
+    static void ForEachRecordInPage(size_t page, const std::string &bytes,
+                                    const std::function<void(size_t, const User &)> &visit) {
+        for (size_t i = 0; i < kRollRecordsPerPage; ++i) {
+            User user;
+            if (DecodeRecord(bytes.substr(i * kRollRecordBytes, kRollRecordBytes), user)) {
+                visit(page * kRollRecordsPerPage + i, user);
+            }
+        }
+    }
+
+    static MerkleHash DigestPageBytes(const std::string &bytes) {
+        return Sha256("page:" + bytes);
+    }
+
+private:
+    struct CachedPage {
+        std::string bytes;
+        std::list<size_t>::iterator lruPosition;
+    };
+
+    std::fstream file_;
+    size_t pageCount_ = 0;
+    size_t capacity_ = 0;
+    size_t recordCount_ = 0;
+    size_t maxPages_ = 1;
+    std::unordered_map<size_t, CachedPage> cache_;
+    std::list<size_t> lru_;
+    std::vector<std::string> arrivalOrder_;
+    std::unordered_map<std::string, size_t> arrivalPosition_;
+    size_t nextArrival_ = 0;
+
+    size_t HomePage(const std::string &cnic) const {
+        return static_cast<size_t>(Fnv1aHash(cnic) % pageCount_);
+    }
+
+    size_t MaxProbes() const {
+        return std::min(pageCount_, kRollMaxProbePages);
+    }
+
+    // A lost header update only undercounts by one record; the next insert
+    // rewrites it.
+    void WriteHeader() {
+        std::string header = EncodeHeader(capacity_, recordCount_);
+        file_.clear();
+        file_.seekp(0);
+        file_.write(header.data(), header.size());
+        file_.flush();
+        file_.clear();
+    }
+
+    static std::string EncodeHeader(size_t capacity, size_t recordCount) {
+        std::string header = kRollHeaderMagic + "|" + std::to_string(capacity) + "|" + std::to_string(recordCount) + "\n";
+        header.resize(kRollPageBytes, '\0');
+        return header;
+    }
+
+    static bool DecodeHeader(const std::string &header, size_t &capacityOut, size_t &recordCountOut) {
+        std::string line = header.substr(0, header.find('\n'));
+        size_t p1 = line.find('|');
+        size_t p2 = line.find('|', p1 + 1);
+        if (p1 == std::string::npos || p2 == std::string::npos || p2 == p1 + 1 || p2 + 1 == line.size() ||
+            line.substr(0, p1) != kRollHeaderMagic || !IsDigits(line.substr(p1 + 1, p2 - p1 - 1)) ||
+            !IsDigits(line.substr(p2 + 1))) {
+            return false;
+        }
+        capacityOut = static_cast<size_t>(std::stoull(line.substr(p1 + 1, p2 - p1 - 1)));
+        recordCountOut = static_cast<size_t>(std::stoull(line.substr(p2 + 1)));
+        return true;
+    }
+
+    void ReadPageFromDisk(size_t page, std::string &bytes) {
+        bytes.assign(kRollPageBytes, '\0');
+        file_.clear();
+        file_.seekg(static_cast<std::streamoff>((page + 1) * kRollPageBytes));
+        file_.read(&bytes[0], kRollPageBytes);
+        file_.clear();
+    }
+
+    const std::string &Page(size_t page) {
+        auto cached = cache_.find(page);
+        if (cached != cache_.end()) {
+            lru_.splice(lru_.begin(), lru_, cached->second.lruPosition);
+            return cached->second.bytes;
+        }
+
+        if (cache_.size() >= maxPages_) {
+            cache_.erase(lru_.back());
+            lru_.pop_back();
+        }
+        lru_.push_front(page);
+        CachedPage &entry = cache_[page];
+        entry.lruPosition = lru_.begin();
+        ReadPageFromDisk(page, entry.bytes);
+        return entry.bytes;
+    }
+
+    static std::string EncodeRecord(const User &user) {
+        std::string line = SerializeUser(user);
+        if (line.size() >= kRollRecordBytes) {
+            return std::string();
+        }
+        line.resize(kRollRecordBytes - 1, ' ');
+        line.push_back('\n');
+        return XorCipher(line, kAdminPassword);
+    }
+
+    static bool DecodeRecord(const std::string &record, User &userOut) {
+        if (record.empty() || record[0] == '\0') {
+            return false;
+        }
+        std::string line = XorCipher(record, kAdminPassword);
+        line.erase(line.find_last_not_of(" \n") + 1);
+        return ParseUser(line, userOut);
+    }
+};
+
+bool PagedRollExists() {
+    std::ifstream existing(kPagedRollFile.c_str());
+    return static_cast<bool>(existing);
+}
+
+MerkleTree BuildMerkleTree(PagedRoll &roll, unsigned threadCount = std::thread::hardware_concurrency()) {
+    std::vector<MerkleHash> leaves;
+    leaves.reserve(roll.PageCount());
+    roll.ForEachPage([&leaves](size_t, const std::string &bytes) {
+        leaves.push_back(PagedRoll::DigestPageBytes(bytes));
+    });
+    return BuildMerkleTreeFromLeaves(std::move(leaves), threadCount);
+}
+
+bool VerifyMerkleTree(PagedRoll &roll, const MerkleHash &expectedRoot,
+                      unsigned threadCount = std::thread::hardware_concurrency()) {
+    return MerkleRoot(BuildMerkleTree(roll, threadCount)) == expectedRoot;
+}
+
+// Once roll_pages.dat exists it is the only roll; the text files are left
+// as they were at import time.
+bool OpenPagedRoll(PagedRoll &roll, size_t memoryBudgetBytes) {
+    if (PagedRollExists()) {
+        return roll.Open(kPagedRollFile, memoryBudgetBytes);
+    }
+
+    // The import is built under a temp name, its root published, and only
+    // then renamed. A temp roll that matches the published root is an import
+    // that crashed before the rename; finish it instead of redoing it.
+    const std::string tempFile = kPagedRollFile + ".tmp";
+    if (roll.Open(tempFile, memoryBudgetBytes)) {
+        MerkleTree tempTree = BuildMerkleTree(roll);
+        roll.Close();
+        size_t leafCount = 0;
+        MerkleHash root{};
+        if (LoadPublishedMerkleRoot(leafCount, root) && leafCount == MerkleLeafCount(tempTree) &&
+            root == MerkleRoot(tempTree) && std::rename(tempFile.c_str(), kPagedRollFile.c_str()) == 0) {
+            return roll.Open(kPagedRollFile, memoryBudgetBytes);
+        }
+    }
+    roll.Close();
+    std::remove(tempFile.c_str());
+
+    // First run in out-of-core mode: import the text roll, but only if it
+    // still matches its published root.
+    std::vector<User> users;
+    std::vector<int> voteCounts;
+    LoadData(users, voteCounts);
+    MerkleTree textTree = BuildMerkleTree(users);
+    if (!RecoverTextRoll(users, voteCounts, textTree)) {
+        return false;
+    }
+
+    size_t capacity = EnvSize("EVS_ROLL_CAPACITY");
+    if (capacity == 0) {
+        capacity = kRollDefaultCapacity;
+    }
+    capacity = std::max(capacity, users.size() + users.size() * kRollGrowthPercent / 100);
+
+    bool imported = PagedRoll::Create(tempFile, capacity) && roll.Open(tempFile, memoryBudgetBytes);
+    for (size_t i = 0; imported && i < users.size(); ++i) {
+        size_t slot = 0;
+        imported = roll.Insert(users[i], slot);
+    }
+    MerkleTree pagedTree;
+    if (imported) {
+        pagedTree = BuildMerkleTree(roll);
+    }
+    roll.Close();
+    if (!imported || !PublishMerkleRoot(pagedTree)) {
+        std::remove(tempFile.c_str());
+        return false;
+    }
+    if (std::rename(tempFile.c_str(), kPagedRollFile.c_str()) != 0) {
+        return false;
+    }
+    return roll.Open(kPagedRollFile, memoryBudgetBytes);
+}
+
+// Vote counts, turnout and the page-level Merkle tree from one sequential
+// pass over the paged roll.
+void ScanPagedRoll(PagedRoll &roll, std::vector<int> &voteCounts, TurnoutIndex &turnout, MerkleTree &merkle) {
+    voteCounts.assign(kCandidateCount, 0);
+    turnout = NewTurnoutIndex(static_cast<long long>(std::time(nullptr)));
+    std::vector<MerkleHash> leaves;
+    leaves.reserve(roll.PageCount());
+    auto countVote = [&voteCounts, &turnout](size_t, const User &user) {
+        if (user.votedFor >= 0 && user.votedFor < kCandidateCount) {
+            voteCounts[user.votedFor] += 1;
+        }
+        RecordVote(turnout, user, false);
+    };
+    roll.ForEachPage([&leaves, &countVote](size_t page, const std::string &bytes) {
+        leaves.push_back(PagedRoll::DigestPageBytes(bytes));
+        PagedRoll::ForEachRecordInPage(page, bytes, countVote);
+    });
+    RebuildTurnoutTotals(turnout);
+    merkle = BuildMerkleTreeFromLeaves(std::move(leaves));
+}
+
+// Stores one record in the paged roll through the journal; the leaf is the
+// record's page.
+bool CommitPagedRecord(PagedRoll &roll, MerkleTree &tree, size_t slot, const User &user) {
+    MerkleHash digest{};
+    if (slot / kRollRecordsPerPage >= roll.PageCount() || !roll.PageDigestWith(slot, user, digest)) {
+        return false;
+    }
+    return CommitMerkleUpdate(tree, slot / kRollRecordsPerPage, digest, slot, user,
+                              [&roll, slot, &user]() { return roll.Write(slot, user); });
+}
+
+// Startup check for the paged roll. A replayed write changes counts and
+// turnout too, so the roll is rescanned after one.
+bool RecoverPagedRoll(PagedRoll &roll, std::vector<int> &voteCounts, TurnoutIndex &turnout, MerkleTree &merkle) {
+    bool replayed = false;
+    bool matches = RecoverPublishedMerkleRoot(merkle, [&roll, &merkle, &replayed](size_t slot, const User &user) {
+        size_t page = slot / kRollRecordsPerPage;
+        if (page >= roll.PageCount() || !roll.Write(slot, user)) {
+            return false;
+        }
+        replayed = true;
+        UpdateMerkleLeaf(merkle, page, roll.PageDigest(page));
+        return true;
+    });
+    if (replayed) {
+        size_t publishedLeafCount = merkle.publishedLeafCount;
+        MerkleHash publishedRoot = merkle.publishedRoot;
+        ScanPagedRoll(roll, voteCounts, turnout, merkle);
+        merkle.publishedLeafCount = publishedLeafCount;
+        merkle.publishedRoot = publishedRoot;
+    }
+    return matches;
+}
+
+std::string TerminalId() {
+    const char *value = std::getenv("EVS_TERMINAL_ID");
+    return (value != nullptr && value[0] != '\0') ? value : "local";
+}
+
+// Memory is fixed at kThrottleShards * kThrottleDepth * kThrottleWidth
+// counters however many CNICs are tried. Counts can only be overestimated,
+// and conservative update keeps that small. Each shard has its own lock and
+// is halved lazily, the first time it is touched in a new half-life.
+// Crossing the threshold also stamps a lockout expiry into a parallel
+// sketch (min of the cells, so it too can only overestimate), which makes
+// every lockout last at least kLockoutSeconds whatever the decay epoch.
+class LoginThrottle {
+public:
+    LoginThrottle() {
+        for (auto &shard : shards_) {
+            shard.counters.assign(kThrottleDepth * kThrottleWidth, 0);
+            shard.lockedUntil.assign(kThrottleDepth * kThrottleWidth, 0);
+        }
+    }
+
+    LoginGate Check(const std::string &terminal, const std::string &cnic, long long now) {
+        if (!TakeTerminalToken(terminal, now)) {
+            return LoginGate::kTerminalLimited;
+        }
+        return IsLockedOut(cnic, now) ? LoginGate::kLockedOut : LoginGate::kAllowed;
+    }
+
+    bool IsLockedOut(const std::string &cnic, long long now) {
+        size_t cells[kThrottleDepth];
+        Shard &shard = Locate(cnic, cells);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Decay(shard, now);
+
+        uint16_t failures = UINT16_MAX;
+        uint32_t lockedUntil = UINT32_MAX;
+        for (size_t cell : cells) {
+            failures = std::min(failures, shard.counters[cell]);
+            lockedUntil = std::min(lockedUntil, shard.lockedUntil[cell]);
+        }
+        return failures >= kLockoutFailures || static_cast<long long>(lockedUntil) > now;
+    }
+
+    void RecordFailure(const std::string &cnic, long long now) {
+        size_t cells[kThrottleDepth];
+        Shard &shard = Locate(cnic, cells);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        Decay(shard, now);
+
+        uint16_t minimum = UINT16_MAX;
+        for (size_t cell : cells) {
+            minimum = std::min(minimum, shard.counters[cell]);
+        }
+        if (minimum == UINT16_MAX) {
+            return;
+        }
+        for (size_t cell : cells) {
+            if (shard.counters[cell] == minimum) {
+                shard.counters[cell] += 1;
+            }
+        }
+        if (minimum + 1 >= kLockoutFailures) {
+            uint32_t until = static_cast<uint32_t>(now + kLockoutSeconds);
+            for (size_t cell : cells) {
+                shard.lockedUntil[cell] = std::max(shard.lockedUntil[cell], until);
+            }
+        }
+    }
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::vector<uint16_t> counters;
+        std::vector<uint32_t> lockedUntil;
+        long long epoch = 0;
+    };
+
+    struct TokenBucket {
+        double tokens = kTerminalBurst;
+        long long lastRefill = 0;
+    };
+
+    Shard shards_[kThrottleShards];
+    std::mutex terminalMutex_;
+    std::unordered_map<std::string, TokenBucket> terminals_;
+
+    // One hash per CNIC: low bits pick the shard, the rest seed the rows.
+    Shard &Locate(const std::string &cnic, size_t (&cells)[kThrottleDepth]) {
+        uint64_t hash = Fnv1aHash(cnic);
+        uint64_t rest = hash / kThrottleShards;
+        uint64_t h1 = rest & 0xffffffffULL;
+        uint64_t h2 = (rest >> 32) | 1;
+        for (size_t row = 0; row < kThrottleDepth; ++row) {
+            cells[row] = row * kThrottleWidth + static_cast<size_t>((h1 + row * h2) % kThrottleWidth);
+        }
+        return shards_[hash % kThrottleShards];
+    }
+
+    static void Decay(Shard &shard, long long now) {
+        long long epoch = now / kFailureHalfLifeSeconds;
+        if (epoch <= shard.epoch) {
+            return;
+        }
+        long long halvings = std::min<long long>(epoch - shard.epoch, 16);
+        shard.epoch = epoch;
+        for (auto &counter : shard.counters) {
+            counter = static_cast<uint16_t>(counter >> halvings);
+        }
+    }
+
+    bool TakeTerminalToken(const std::string &terminal, long long now) {
+        std::lock_guard<std::mutex> lock(terminalMutex_);
+        auto found = terminals_.find(terminal);
+        if (found == terminals_.end()) {
+            found = terminals_.emplace(terminal, TokenBucket()).first;
+            found->second.lastRefill = now;
+        }
+
+        TokenBucket &bucket = found->second;
+        if (now > bucket.lastRefill) {
+            double refill = (now - bucket.lastRefill) * kTerminalAttemptsPerMinute / 60.0;
+            bucket.tokens = std::min(kTerminalBurst, bucket.tokens + refill);
+            bucket.lastRefill = now;
+        }
+        if (bucket.tokens < 1.0) {
+            return false;
+        }
+        bucket.tokens -= 1.0;
+        return true;
+    }
+};
+
 }  // namespace backend
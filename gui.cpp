@@ -1,6 +1,10 @@
 #include <QtCore/QCoreApplication>
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QDateTime>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMetaObject>
+#include <QtCore/QTimer>
 #include <QtGui/QFont>
 #include <QtGui/QPainter>
 #include <QtGui/QPainterPath>
@@ -17,11 +21,15 @@
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QScrollArea>
+#include <QtWidgets/QStatusBar>
 #include <QtWidgets/QTabWidget>
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QWidget>
 
+#include <ctime>
+#include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
 class PieChartWidget : public QWidget {
@@ -86,28 +94,9 @@ private:
 
 class MainWindow : public QMainWindow {
 public:
-    MainWindow() {
-        backend::LoadData(users_, voteCounts_);
-        if (voteCounts_.size() != static_cast<size_t>(backend::kCandidateCount)) {
-            voteCounts_.assign(backend::kCandidateCount, 0);
-        }
-
-        auto *tabs = new QTabWidget();
-        tabs->addTab(buildRegisterTab(), "Register");
-        tabs->addTab(buildVoteTab(), "Login & Vote");
-        tabs->addTab(buildResultsTab(), "Admin");
-
-        auto *container = new QWidget();
-        auto *layout = new QVBoxLayout(container);
-        layout->setContentsMargins(18, 18, 18, 18);
-        layout->setSpacing(16);
-        layout->addWidget(buildHeader());
-        layout->addWidget(tabs);
-        setCentralWidget(container);
-
-        setWindowTitle("Electronic Voting System");
-        resize(560, 420);
-
+    explicit MainWindow(const QElapsedTimer &startupClock) : startupClock_(startupClock) {
+        // Style and font go on before any child exists so each widget is
+        // polished once, when it is created.
         QFont appFont("Helvetica Neue", 13);
         setFont(appFont);
 
@@ -136,11 +125,86 @@ public:
             "QMessageBox QPushButton { background-color: #4f6bed; color: white; border: none; border-radius: 8px; padding: 6px 16px; }"
             "QMessageBox QPushButton:hover { background-color: #4159c9; }"
         );
+
+        tabs_ = new QTabWidget();
+        const char *tabTitles[kTabCount] = {"Register", "Login & Vote", "Admin"};
+        for (int i = 0; i < kTabCount; ++i) {
+            tabPages_[i] = new QWidget();
+            auto *pageLayout = new QVBoxLayout(tabPages_[i]);
+            pageLayout->setContentsMargins(0, 0, 0, 0);
+            tabs_->addTab(tabPages_[i], tabTitles[i]);
+        }
+        ensureTabBuilt(0);
+        connect(tabs_, &QTabWidget::currentChanged, [this](int index) { ensureTabBuilt(index); });
+
+        auto *container = new QWidget();
+        auto *layout = new QVBoxLayout(container);
+        layout->setContentsMargins(18, 18, 18, 18);
+        layout->setSpacing(16);
+        layout->addWidget(buildHeader());
+        layout->addWidget(tabs_);
+        setCentralWidget(container);
+
+        setWindowTitle("Electronic Voting System");
+        resize(560, 420);
+
+        statusBar()->showMessage("Loading voter roll...");
+        loadThread_ = std::thread([this]() {
+            auto loaded = std::make_shared<LoadedRoll>(loadRoll());
+            QMetaObject::invokeMethod(this, [this, loaded]() { applyLoadedRoll(std::move(*loaded)); },
+                                      Qt::QueuedConnection);
+        });
+    }
+
+    ~MainWindow() override {
+        if (loadThread_.joinable()) {
+            loadThread_.join();
+        }
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override {
+        QMainWindow::paintEvent(event);
+        if (firstFrameMs_ < 0) {
+            firstFrameMs_ = startupClock_.elapsed();
+            QTimer::singleShot(0, this, [this]() { reportStartupIfDone(); });
+        }
     }
 
 private:
+    struct LoadedRoll {
+        std::vector<backend::User> users;
+        std::unique_ptr<backend::PagedRoll> roll;
+        std::vector<int> voteCounts;
+        backend::MerkleTree merkle;
+        backend::TurnoutIndex turnout;
+        std::unique_ptr<backend::LoginThrottle> loginThrottle;
+        bool publishedRootMatches = true;
+        QString error;
+    };
+
+    static constexpr int kTabCount = 3;
+
+    QElapsedTimer startupClock_;
+    qint64 firstFrameMs_ = -1;
+    qint64 readyMs_ = -1;
+    bool startupReported_ = false;
+    std::thread loadThread_;
+    bool rollReady_ = false;
+    bool publishedRootMatched_ = true;
+    QString rollError_;
+
+    QTabWidget *tabs_ = nullptr;
+    QWidget *tabPages_[kTabCount] = {nullptr, nullptr, nullptr};
+    bool tabBuilt_[kTabCount] = {false, false, false};
+
     std::vector<backend::User> users_;
+    std::unique_ptr<backend::PagedRoll> roll_;
     std::vector<int> voteCounts_;
+    backend::MerkleTree merkle_;
+    backend::TurnoutIndex turnout_;
+    std::unique_ptr<backend::LoginThrottle> loginThrottle_;
+    std::string terminalId_ = backend::TerminalId();
 
     QLineEdit *regCnic_ = nullptr;
     QLineEdit *regPassword_ = nullptr;
@@ -149,15 +213,167 @@ private:
     QLineEdit *loginPassword_ = nullptr;
     QComboBox *candidatePicker_ = nullptr;
     QPushButton *voteButton_ = nullptr;
-    int loggedInIndex_ = -1;
+    long long loggedInSlot_ = -1;
 
     QLineEdit *adminPassword_ = nullptr;
+    QLineEdit *auditCnic_ = nullptr;
     QLabel *resultsLabel_ = nullptr;
     QGroupBox *resultsPanel_ = nullptr;
     QScrollArea *resultsScroll_ = nullptr;
     QLabel *countLabels_[backend::kCandidateCount] = {nullptr, nullptr, nullptr};
     PieChartWidget *pieChart_ = nullptr;
     QWidget *legendWidget_ = nullptr;
+    QLabel *turnoutLabel_ = nullptr;
+
+    // Runs on the load thread, so it touches no members. Out-of-core when
+    // EVS_ROLL_CACHE_MB is set; otherwise the whole roll lives in users_.
+    // The login throttle's sketches are allocated here too, off the GUI
+    // thread.
+    static LoadedRoll loadRoll() {
+        LoadedRoll loaded;
+        loaded.loginThrottle = std::make_unique<backend::LoginThrottle>();
+        size_t cacheBudget = backend::RollCacheBudgetBytes();
+        if (cacheBudget > 0) {
+            loaded.roll = std::make_unique<backend::PagedRoll>();
+            if (!backend::OpenPagedRoll(*loaded.roll, cacheBudget)) {
+                loaded.roll.reset();
+                loaded.error = "The paged voter roll could not be opened or imported. "
+                               "No votes can be taken until it is fixed.";
+                return loaded;
+            }
+            loaded.roll->SetArrivalOrder(backend::LoadStationVoters());
+            backend::ScanPagedRoll(*loaded.roll, loaded.voteCounts, loaded.turnout, loaded.merkle);
+            loaded.publishedRootMatches =
+                backend::RecoverPagedRoll(*loaded.roll, loaded.voteCounts, loaded.turnout, loaded.merkle);
+            return loaded;
+        }
+
+        // The text roll is stale once a paged roll exists; never use it silently.
+        if (backend::PagedRollExists()) {
+            loaded.error = "This booth uses the paged voter roll (voting_data/roll_pages.dat). "
+                           "Set EVS_ROLL_CACHE_MB to start it.";
+            return loaded;
+        }
+
+        backend::LoadData(loaded.users, loaded.voteCounts);
+        loaded.merkle = backend::BuildMerkleTree(loaded.users);
+        loaded.publishedRootMatches = backend::RecoverTextRoll(loaded.users, loaded.voteCounts, loaded.merkle);
+        loaded.turnout = backend::BuildTurnoutIndex(loaded.users);
+        return loaded;
+    }
+
+    void applyLoadedRoll(LoadedRoll &&loaded) {
+        if (!loaded.error.isEmpty()) {
+            rollError_ = loaded.error;
+            readyMs_ = startupClock_.elapsed();
+            reportStartupIfDone();
+            showMessage("Voter roll unavailable", rollError_);
+            return;
+        }
+
+        users_ = std::move(loaded.users);
+        roll_ = std::move(loaded.roll);
+        voteCounts_ = std::move(loaded.voteCounts);
+        merkle_ = std::move(loaded.merkle);
+        turnout_ = std::move(loaded.turnout);
+        loginThrottle_ = std::move(loaded.loginThrottle);
+        publishedRootMatched_ = loaded.publishedRootMatches;
+        rollReady_ = true;
+        readyMs_ = startupClock_.elapsed();
+        reportStartupIfDone();
+        if (!publishedRootMatched_) {
+            showMessage("Integrity warning", "Stored vote records do not match the last published Merkle root.");
+        }
+    }
+
+    void reportStartupIfDone() {
+        if (startupReported_ || firstFrameMs_ < 0 || readyMs_ < 0) {
+            return;
+        }
+        startupReported_ = true;
+        bool rollLoaded = rollError_.isEmpty();
+        if (!rollLoaded) {
+            statusBar()->showMessage(QString("Voter roll unavailable (failed after %1 ms).").arg(readyMs_));
+            backend::AppendStartupTiming(firstFrameMs_, readyMs_, false);
+            return;
+        }
+        bool overTarget = firstFrameMs_ > backend::kFirstFrameTargetMs || readyMs_ > backend::kReadyTargetMs;
+        statusBar()->showMessage(QString("First frame %1 ms, ready %2 ms%3")
+                                     .arg(firstFrameMs_)
+                                     .arg(readyMs_)
+                                     .arg(overTarget ? " (over target)" : ""));
+        backend::AppendStartupTiming(firstFrameMs_, readyMs_, true);
+    }
+
+    bool ensureRollReady() {
+        if (!rollError_.isEmpty()) {
+            showMessage("Voter roll unavailable", rollError_);
+        } else if (!rollReady_) {
+            showMessage("Please wait", "The voter roll is still loading.");
+        }
+        return rollReady_;
+    }
+
+    void ensureTabBuilt(int index) {
+        if (index < 0 || index >= kTabCount || tabBuilt_[index]) {
+            return;
+        }
+        tabBuilt_[index] = true;
+
+        QWidget *content = nullptr;
+        switch (index) {
+            case 0:
+                content = buildRegisterTab();
+                break;
+            case 1:
+                content = buildVoteTab();
+                break;
+            default:
+                content = buildResultsTab();
+                break;
+        }
+        tabPages_[index]->layout()->addWidget(content);
+    }
+
+    bool findVoter(const std::string &cnic, backend::User &userOut, size_t &slotOut) {
+        if (roll_) {
+            return roll_->Find(cnic, userOut, slotOut);
+        }
+        int index = -1;
+        if (!backend::FindUserIndex(users_, cnic, index)) {
+            return false;
+        }
+        userOut = users_[index];
+        slotOut = static_cast<size_t>(index);
+        return true;
+    }
+
+    bool loadVoter(size_t slot, backend::User &userOut) {
+        if (roll_) {
+            return roll_->Read(slot, userOut);
+        }
+        if (slot >= users_.size()) {
+            return false;
+        }
+        userOut = users_[slot];
+        return true;
+    }
+
+    bool addVoter(const backend::User &user) {
+        if (roll_) {
+            size_t slot = 0;
+            return roll_->FindFreeSlot(user.cnic, slot) && backend::CommitPagedRecord(*roll_, merkle_, slot, user);
+        }
+        return backend::CommitUserRecord(users_, merkle_, users_.size(), user);
+    }
+
+    // Every write publishes the new Merkle root in the same step.
+    bool storeVoter(size_t slot, const backend::User &user) {
+        if (roll_) {
+            return backend::CommitPagedRecord(*roll_, merkle_, slot, user);
+        }
+        return backend::CommitUserRecord(users_, merkle_, slot, user);
+    }
 
     QString resolveAssetPath(const QString &relativePath) {
         QDir appDir(QCoreApplication::applicationDirPath());
@@ -182,9 +398,9 @@ private:
         layout->setSpacing(12);
 
         auto *evmLogo = new QLabel();
-        QPixmap evmPixmap(resolveAssetPath("logos/evm_logo.png"));
+        QPixmap evmPixmap = loadRoundLogo("logos/evm_logo.png", 72);
         if (!evmPixmap.isNull()) {
-            evmLogo->setPixmap(makeRoundPixmap(evmPixmap, 72));
+            evmLogo->setPixmap(evmPixmap);
         }
         evmLogo->setFixedSize(80, 80);
         evmLogo->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
@@ -198,9 +414,9 @@ private:
         title->setStyleSheet("color: #1f2937;");
 
         auto *uniLogo = new QLabel();
-        QPixmap uniPixmap(resolveAssetPath("logos/uni_logo.jpeg"));
+        QPixmap uniPixmap = loadRoundLogo("logos/uni_logo.jpeg", 60);
         if (!uniPixmap.isNull()) {
-            uniLogo->setPixmap(makeRoundPixmap(uniPixmap, 60));
+            uniLogo->setPixmap(uniPixmap);
         }
         uniLogo->setFixedSize(66, 66);
         uniLogo->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
@@ -212,6 +428,37 @@ private:
         return header;
     }
 
+    // Rounded logos are cached as PNGs keyed on the source's size and mtime,
+    // so later startups skip decoding and smooth-scaling the originals.
+    QPixmap loadRoundLogo(const QString &relativePath, int size) {
+        QString sourcePath = resolveAssetPath(relativePath);
+        QFileInfo sourceInfo(sourcePath);
+        if (!sourceInfo.exists()) {
+            return QPixmap();
+        }
+
+        QDir cacheDir(QString::fromStdString(backend::kLogoCacheDir));
+        QString cachePath = cacheDir.filePath(QString("%1_%2_%3_%4.png")
+                                                  .arg(sourceInfo.completeBaseName())
+                                                  .arg(size)
+                                                  .arg(sourceInfo.size())
+                                                  .arg(sourceInfo.lastModified().toMSecsSinceEpoch()));
+        QPixmap cached;
+        if (cached.load(cachePath)) {
+            return cached;
+        }
+
+        QPixmap source(sourcePath);
+        if (source.isNull()) {
+            return QPixmap();
+        }
+        QPixmap rounded = makeRoundPixmap(source, size);
+        if (cacheDir.mkpath(".")) {
+            rounded.save(cachePath, "PNG");
+        }
+        return rounded;
+    }
+
     QPixmap makeRoundPixmap(const QPixmap &source, int size) {
         QPixmap scaled = source.scaled(size, size, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
         QPixmap output(size, size);
@@ -317,11 +564,22 @@ private:
         adminPassword_ = new QLineEdit();
         adminPassword_->setEchoMode(QLineEdit::Password);
         form->addRow("Admin password:", adminPassword_);
+        auditCnic_ = new QLineEdit();
+        auditCnic_->setPlaceholderText("CNIC, or FIRST-LAST for a range");
+        form->addRow("Audit CNIC:", auditCnic_);
 
         auto *showButton = new QPushButton("Show Results");
         showButton->setMinimumHeight(36);
         connect(showButton, &QPushButton::clicked, [this]() { handleShowResults(); });
 
+        auto *verifyButton = new QPushButton("Verify Integrity");
+        verifyButton->setMinimumHeight(36);
+        connect(verifyButton, &QPushButton::clicked, [this]() { handleVerifyIntegrity(); });
+
+        auto *auditButton = new QPushButton("Audit Record");
+        auditButton->setMinimumHeight(36);
+        connect(auditButton, &QPushButton::clicked, [this]() { handleAuditRecord(); });
+
         resultsLabel_ = new QLabel();
         resultsLabel_->setText("Results hidden.");
         resultsLabel_->setStyleSheet("color: #374151; font-weight: 600;");
@@ -403,6 +661,8 @@ private:
 
         layout->addLayout(form);
         layout->addWidget(showButton);
+        layout->addWidget(verifyButton);
+        layout->addWidget(auditButton);
         layout->addWidget(resultsLabel_);
         resultsScroll_ = new QScrollArea();
         resultsScroll_->setWidgetResizable(true);
@@ -420,13 +680,22 @@ private:
         resultsScroll_->setWidget(resultsPanel_);
         resultsScroll_->setVisible(false);
 
+        turnoutLabel_ = new QLabel();
+        turnoutLabel_->setStyleSheet("color: #374151;");
+        turnoutLabel_->setVisible(false);
+
         layout->addWidget(resultsScroll_);
+        layout->addWidget(turnoutLabel_);
         layout->addStretch();
         return tab;
     }
 
     void handleRegister() {
-        if (static_cast<int>(users_.size()) >= backend::kMaxUsers) {
+        if (!ensureRollReady()) {
+            return;
+        }
+
+        if (!roll_ && static_cast<int>(users_.size()) >= backend::kMaxUsers) {
             showMessage("Registration closed", "User limit reached.");
             return;
         }
@@ -439,8 +708,9 @@ private:
             return;
         }
 
-        int existingIndex = -1;
-        if (backend::FindUserIndex(users_, cnic, existingIndex)) {
+        backend::User existingUser;
+        size_t existingSlot = 0;
+        if (findVoter(cnic, existingUser, existingSlot)) {
             showMessage("Already registered", "This CNIC is already registered.");
             return;
         }
@@ -448,8 +718,10 @@ private:
         backend::User newUser;
         newUser.cnic = cnic;
         newUser.password = backend::HashPassword(password, cnic);
-        users_.push_back(newUser);
-        backend::SaveData(users_);
+        if (!addVoter(newUser)) {
+            showMessage("Registration closed", "Voter roll is full.");
+            return;
+        }
 
         regCnic_->clear();
         regPassword_->clear();
@@ -457,46 +729,82 @@ private:
     }
 
     void handleLogin() {
+        if (!ensureRollReady()) {
+            return;
+        }
+
         std::string cnic = loginCnic_->text().toStdString();
         std::string password = loginPassword_->text().toStdString();
 
-        int index = -1;
-        if (!backend::FindUserIndex(users_, cnic, index)) {
+        long long now = static_cast<long long>(std::time(nullptr));
+        switch (loginThrottle_->Check(terminalId_, cnic, now)) {
+            case backend::LoginGate::kTerminalLimited:
+                showMessage("Too many attempts", "This booth is temporarily rate limited. Please wait.");
+                return;
+            case backend::LoginGate::kLockedOut:
+                showMessage("Login locked", "Too many failed attempts for this CNIC. Try again later.");
+                return;
+            case backend::LoginGate::kAllowed:
+                break;
+        }
+
+        backend::User user;
+        size_t slot = 0;
+        if (!findVoter(cnic, user, slot)) {
+            loginThrottle_->RecordFailure(cnic, now);
             showMessage("Login failed", "User not found.");
             return;
         }
 
-        if (users_[index].password != backend::HashPassword(password, cnic)) {
+        if (user.password != backend::HashPassword(password, cnic)) {
+            loginThrottle_->RecordFailure(cnic, now);
             showMessage("Login failed", "Invalid password.");
             return;
         }
 
-        loggedInIndex_ = index;
+        loggedInSlot_ = static_cast<long long>(slot);
         voteButton_->setEnabled(true);
+        if (roll_) {
+            QTimer::singleShot(0, this, [this]() { roll_->PrefetchUpcoming(); });
+        }
         showMessage("Login successful", "You can now cast your vote.");
     }
 
     void handleVote() {
-        if (loggedInIndex_ < 0 || loggedInIndex_ >= static_cast<int>(users_.size())) {
+        if (!ensureRollReady()) {
+            return;
+        }
+
+        backend::User user;
+        if (loggedInSlot_ < 0 || !loadVoter(static_cast<size_t>(loggedInSlot_), user)) {
             showMessage("Session error", "Please login first.");
             return;
         }
 
-        if (users_[loggedInIndex_].voted) {
+        if (user.voted) {
             showMessage("Duplicate vote", "You have already voted.");
             return;
         }
 
         int candidateIndex = candidatePicker_->currentData().toInt();
-        users_[loggedInIndex_].voted = true;
-        users_[loggedInIndex_].votedFor = candidateIndex;
+        user.voted = true;
+        user.votedFor = candidateIndex;
+        user.votedAt = static_cast<long long>(std::time(nullptr));
+        if (!storeVoter(static_cast<size_t>(loggedInSlot_), user)) {
+            showMessage("Storage error", "Your vote could not be saved.");
+            return;
+        }
         voteCounts_[candidateIndex] += 1;
-        backend::SaveData(users_);
+        backend::RecordVote(turnout_, user);
 
         showMessage("Vote cast", "Your vote has been recorded.");
     }
 
     void handleShowResults() {
+        if (!ensureRollReady()) {
+            return;
+        }
+
         std::string adminPassword = adminPassword_->text().toStdString();
         if (adminPassword != backend::kAdminPassword) {
             showMessage("Unauthorized", "Invalid admin password.");
@@ -521,6 +829,114 @@ private:
         if (resultsScroll_) {
             resultsScroll_->setVisible(true);
         }
+        if (turnoutLabel_) {
+            turnoutLabel_->setText(turnoutSummary());
+            turnoutLabel_->setVisible(true);
+        }
+    }
+
+    QString turnoutSummary() const {
+        const long long now = static_cast<long long>(std::time(nullptr));
+        const long long hour = 60 * 60;
+        QString summary = QString("Turnout: %1 this hour, %2 in the last 24 hours, %3 today (UTC)")
+                              .arg(backend::TurnoutInBucket(turnout_.total, backend::TurnoutBucket::kHour, now))
+                              .arg(backend::TurnoutBetween(turnout_.total, now - 24 * hour, now + 1))
+                              .arg(backend::TurnoutInBucket(turnout_.total, backend::TurnoutBucket::kDay, now));
+        for (int i = 0; i < backend::kCandidateCount; ++i) {
+            summary += QString("\n%1: %2 in the last hour")
+                           .arg(QString::fromUtf8(backend::kCandidates[i]))
+                           .arg(backend::TurnoutBetween(turnout_.byCandidate[i], now - hour, now + 1));
+        }
+        return summary;
+    }
+
+    void handleVerifyIntegrity() {
+        if (!ensureRollReady()) {
+            return;
+        }
+
+        std::string adminPassword = adminPassword_->text().toStdString();
+        if (adminPassword != backend::kAdminPassword) {
+            showMessage("Unauthorized", "Invalid admin password.");
+            return;
+        }
+
+        if (!publishedRootMatched_) {
+            showMessage("Integrity check failed", "Stored vote records did not match the last published root at startup.");
+            return;
+        }
+        if (!backend::PublishedMerkleRootIntact(merkle_)) {
+            showMessage("Integrity check failed", "The published Merkle roots file has been changed.");
+            return;
+        }
+
+        bool matches = false;
+        if (roll_) {
+            matches = backend::VerifyMerkleTree(*roll_, backend::MerkleRoot(merkle_));
+        } else {
+            std::vector<backend::User> storedUsers;
+            std::vector<int> storedCounts;
+            backend::LoadData(storedUsers, storedCounts);
+            matches = backend::VerifyMerkleTree(storedUsers, backend::MerkleRoot(merkle_));
+        }
+        if (!matches) {
+            showMessage("Integrity check failed", "Stored vote records do not match the current Merkle root.");
+            return;
+        }
+
+        showMessage("Integrity verified", "Stored vote records match the Merkle root.");
+    }
+
+    // Checks one voter's leaf, or every leaf between two voters, against the
+    // last published root with a Merkle proof. Leaves are re-read from disk;
+    // the paged roll reads only the pages in range.
+    void handleAuditRecord() {
+        if (!ensureRollReady()) {
+            return;
+        }
+
+        std::string adminPassword = adminPassword_->text().toStdString();
+        if (adminPassword != backend::kAdminPassword) {
+            showMessage("Unauthorized", "Invalid admin password.");
+            return;
+        }
+
+        std::string input = auditCnic_->text().trimmed().toStdString();
+        size_t dash = input.find('-');
+        std::string cnics[2] = {input.substr(0, dash), dash == std::string::npos ? input : input.substr(dash + 1)};
+        size_t leaves[2] = {0, 0};
+        for (int i = 0; i < 2; ++i) {
+            backend::User user;
+            size_t slot = 0;
+            if (!backend::IsValidCnic(cnics[i]) || !findVoter(cnics[i], user, slot)) {
+                showMessage("Audit", "Enter a registered CNIC, or two separated by '-'.");
+                return;
+            }
+            leaves[i] = roll_ ? slot / backend::kRollRecordsPerPage : slot;
+        }
+        size_t first = std::min(leaves[0], leaves[1]);
+        size_t last = std::max(leaves[0], leaves[1]) + 1;
+
+        std::vector<backend::MerkleHash> stored;
+        if (roll_) {
+            for (size_t page = first; page < last; ++page) {
+                stored.push_back(roll_->DiskPageDigest(page));
+            }
+        } else {
+            std::vector<backend::User> storedUsers;
+            std::vector<int> storedCounts;
+            backend::LoadData(storedUsers, storedCounts);
+            for (size_t i = first; i < last && i < storedUsers.size(); ++i) {
+                stored.push_back(backend::HashVoteRecord(storedUsers[i]));
+            }
+        }
+
+        QString leafRange = QString("%1 %2-%3").arg(roll_ ? "pages" : "records").arg(first).arg(last - 1);
+        if (!backend::AuditAgainstPublishedRoot(merkle_, first, std::move(stored))) {
+            showMessage("Audit failed", QString("Stored %1 do not match the last published root.").arg(leafRange));
+            return;
+        }
+        showMessage("Audit passed", QString("Stored %1 match the last published root.").arg(leafRange));
     }
 
     void showMessage(const QString &title, const QString &message) {
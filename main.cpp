@@ -1,11 +1,15 @@
+#include <QtCore/QElapsedTimer>
 #include <QtWidgets/QApplication>
 
 #include "backend.cpp"
 #include "gui.cpp"
 
 int main(int argc, char *argv[]) {
+    QElapsedTimer startupClock;
+    startupClock.start();
+
     QApplication app(argc, argv);
-    MainWindow window;
+    MainWindow window(startupClock);
     window.show();
     return app.exec();
 }